@@ -0,0 +1,88 @@
+/********************************************************************************
+
+                    Analysis of the community cards of a deal.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The community cards are the same for all the players, so everything which
+ depends only on them is found once per deal:
+
+ suit_masks -- suit masks of the community cards, in the format of HandEvaluator
+               (bit j is the column j of the CheckSet table, Ace in bits 0, 13).
+ suit_counts -- number of community cards of each suit.
+ max_suit_cards -- largest number of community cards of one suit.
+ max_window_ranks -- largest number of community ranks in five consecutive
+               columns, i.e. in the window of a single straight.
+
+ The best hand of a player is found by folding the pocket cards of the player
+ into the summary with score_with(). The flush (straight) search is skipped
+ when the pocket cards can't bring the largest suit (straight window) to five
+ cards. Only what score_with() needs is found here, since it runs on every
+ deal; the other features of the community cards are in FlopTextureIndex.h.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+class BoardSummary{
+
+public:
+
+    // Empty board (e.g. Seven-card stud, or before the flop).
+    BoardSummary() : BoardSummary(array<int,4>{}) {};
+
+    BoardSummary(const array<int,4> & masks){
+        suit_masks=masks;
+        int any=0;
+        max_suit_cards=0;
+        for(int i=0;i<4;++i){
+            suit_counts[i]=__builtin_popcount(masks[i]&HandEvaluator::ranks_mask);
+            max_suit_cards=max(max_suit_cards,suit_counts[i]);
+            any|=masks[i];
+        }
+        max_window_ranks=0;
+        for(int h=4;h<14;++h)
+            max_window_ranks=max(max_window_ranks,__builtin_popcount(any&(0x1F<<(h-4))));
+    }
+
+    // Return score of the best hand made of the community cards and the
+    // pocket cards with the suit masks hole_masks. If low is not null, save
+    // the score of the best 8-or-better low hand (see HandEvaluator.h) in it.
+    int score_with(const array<int,4> & hole_masks,int * low=0) const{
+        array<int,4> masks;
+        int hole_cards=0;
+        for(int i=0;i<4;++i){
+            masks[i]=suit_masks[i]|hole_masks[i];
+            hole_cards+=__builtin_popcount(hole_masks[i]&HandEvaluator::ranks_mask);
+        }
+        return HandEvaluator::score(masks,
+                                    max_suit_cards+hole_cards>=5,
+                                    max_window_ranks+hole_cards>=5,
+                                    low);
+    }
+
+    // Interface to the private variables:
+
+    array<int,4> get_suit_masks() const{
+        return suit_masks;
+    }
+    array<int,4> get_suit_counts() const{
+        return suit_counts;
+    }
+    int get_max_suit_cards() const{
+        return max_suit_cards;
+    }
+    int get_max_window_ranks() const{
+        return max_window_ranks;
+    }
+
+private:
+
+    array<int,4> suit_masks;
+    array<int,4> suit_counts;
+    int max_suit_cards;
+    int max_window_ranks;
+
+};
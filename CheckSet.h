@@ -12,6 +12,10 @@
  with indexes 0 and 13. This makes it more convenient to analyze Ace-low and
  Ace-high straights.
  
+ The community cards are analysed only once per deal (see BoardSummary.h), and
+ are copied to the players' tables only when the tables are used by the checkers
+ or the printing functions.
+ 
  Player's p index starts with 1. This is since 0 would usually mean absence of
  a card.
  
@@ -38,6 +42,10 @@
  This way we can differentiate fine strategies which depend on which stage of
  the game we are on.
  
+ winning_players_hilo() returns the separate winners of the high and the low
+ halves of the pot in the Hi-Lo (8-or-better) games, in which any five of the
+ cards of the player make the low hand.
+
  The used ranking of hands is:
  0 -- High Card
  1 -- One Pair
@@ -51,11 +59,61 @@
  
  The functions which check for the specific ranks always return the highest
  possible hand of that rank (such as, the highest flush, etc).
+
+ Building the vectors of Cards is slow, so the classification goes through
+ HandResult: classify(p) scores the hand of player p with HandEvaluator (see
+ HandEvaluator.h), and the five Cards of the hand are built only when
+ HandResult::cards() is called. bestHand_rank() and winning_players() only use
+ the scores and never build the Cards.
  
 ********************************************************************************/
 
 using namespace std;
 
+class CheckSet;
+
+// Result of classification of the hand of player p: the hand ranking and the
+// score of the hand. The Cards of the hand are found by the corresponding
+// checker of the CheckSet on the first call to cards(). The CheckSet must
+// outlive the HandResult.
+class HandResult{
+    
+public:
+    
+    HandResult(CheckSet * cs,int p,int s) : checkset(cs), player(p), hand_score(s), materialized(false) {};
+    
+    int get_player() const{
+        return player;
+    }
+    int category() const{
+        return HandEvaluator::category(hand_score);
+    }
+    int score() const{
+        return hand_score;
+    }
+    
+    // Return best hand of the player, building it at the first call.
+    const vector<Card> & cards();
+    
+private:
+    
+    CheckSet * checkset;
+    int player;
+    int hand_score;
+    bool materialized;
+    vector<Card> hand;
+    
+};
+
+// Winners of a Hi-Lo (8-or-better) game. low is empty if no player has a
+// qualifying low hand, in which case the high hand wins the whole pot.
+// scoops are the players who win the whole pot alone.
+struct HiLoWinners{
+    vector<int> high;
+    vector<int> low;
+    vector<int> scoops;
+};
+
 class CheckSet{
     
 public:
@@ -75,47 +133,65 @@ public:
         suit_to_index={{'H',0},{'S',1},{'D',2},{'C',3}};
         index_to_suit={{0,'H'},{1,'S'},{2,'D'},{3,'C'}};
         
+        array<int,4> board_masks={};
         for(Card c : Cards){
             int p=c.player;
-            if(p==-1)
-                continue; // Ignore at first passing the community cards.
+            int suit_i=suit_to_index[c.suit];
+            int rank_i= c.rank=="A" ? 13 : rank_to_index[c.rank];
+            if(p==-1){
+                // The community cards are analysed once for all the players, and
+                // are added to the players' tables only when the tables are used.
+                community_cards.push_back(c);
+                board_masks[suit_i]|=1<<rank_i;
+                if(rank_i==13)
+                    board_masks[suit_i]|=1;
+                continue;
+            }
             if(find(players.begin(),players.end(),p)==players.end()){
                 players.push_back(p);
                 vector<vector<int>> players_table(4,vector<int>(14,0));
                 players_cards[p]=players_table;
+                hole_masks[p]={};
             }
-            int suit_i=suit_to_index[c.suit];
+            hole_masks[p][suit_i]|=1<<rank_i;
             if(c.rank=="A"){
                 players_cards[p][suit_i][0]=p;
                 players_cards[p][suit_i][13]=p;
+                hole_masks[p][suit_i]|=1;
             }
             else{
-                int rank_i=rank_to_index[c.rank];
                 players_cards[p][suit_i][rank_i]=p;
             }
         }
         sort(players.begin(),players.end());
-        // Populate the community cards.
-        for(Card c : Cards){
-            if(c.player==-1){
-                for(int i=0;i<players.size();++i){
-                    int p=players[i];
-                    int suit_i=suit_to_index[c.suit];
-                    if(c.rank=="A"){
-                        players_cards[p][suit_i][0]=-1;
-                        players_cards[p][suit_i][13]=-1;
-                    }
-                    else{
-                        int rank_i=rank_to_index[c.rank];
-                        players_cards[p][suit_i][rank_i]=-1;
-                    }
+        board=BoardSummary(board_masks);
+        community_populated=false;
+    }
+    
+    // Populate the community cards in the players' tables, if not yet done.
+    void populate_community(){
+        if(community_populated)
+            return;
+        for(Card c : community_cards){
+            for(int i=0;i<players.size();++i){
+                int p=players[i];
+                int suit_i=suit_to_index[c.suit];
+                if(c.rank=="A"){
+                    players_cards[p][suit_i][0]=-1;
+                    players_cards[p][suit_i][13]=-1;
+                }
+                else{
+                    int rank_i=rank_to_index[c.rank];
+                    players_cards[p][suit_i][rank_i]=-1;
                 }
             }
         }
+        community_populated=true;
     }
     
     // Print table of cards for player p.
     void printPlayerCardTable(int p){
+        populate_community();
         cout << "Player " << p << " has cards table " << endl;
         cout << "   A   2   3   4   5   6   7   8   9   10  J   Q   K   A" << endl;
         for(int i=0;i<4;++i){
@@ -138,6 +214,7 @@ public:
     
     // Print combined table of cards for all the players.
     void printTotalCardTable(){
+        populate_community();
         cout << " All the cards dealt are " << endl;
         cout << "   A   2   3   4   5   6   7   8   9   10  J   Q   K   A" << endl;
         for(int i=0;i<4;++i){
@@ -167,6 +244,7 @@ public:
     
     // Print cards of player p.
     void printPlayersCards(int p){
+        populate_community();
         cout << "Player " << p << " has cards" << endl;
         for(int i=0;i<4;++i){
             for(int j=1;j<14;++j){
@@ -184,6 +262,7 @@ public:
     // as a vector, with the cards sorted in decreasing rank.
     // Else return an empty vector.
     vector<Card> isStraightFlush(int p){
+        populate_community();
         vector<Card> ret;
         for(int i=0;i<4;++i){
             int j=13;
@@ -223,6 +302,7 @@ public:
     // followed by the highest possible kicker as a vector.
     // Else return an empty vector.
     vector<Card> isFourOfAKind(int p){
+        populate_community();
         vector<Card> ret;
         for(int i=13;i>=1;--i){ // Make sure not to count each Ace twice
             bool found_four=true;
@@ -266,6 +346,7 @@ public:
     // as a vector, where three cards preceed two cards.
     // Else return an empty vector.
     vector<Card> isFullHouse(int p){
+        populate_community();
         vector<Card> ret;
         vector<Card> three;
         vector<Card> two;
@@ -310,6 +391,7 @@ public:
     // where the cards are sorted in decreasing rank.
     // Else return an empty vector.
     vector<Card> isFlush(int p){
+        populate_community();
         vector<Card> ret;
         for(int i=0;i<4;++i){
             int j=13;
@@ -358,6 +440,7 @@ public:
     // where the cards are sorted in decreasing rank.
     // Else return an empty vector.
     vector<Card> isStraight(int p){
+        populate_community();
         vector<Card> ret;
         int i=13;
         while(i>3){
@@ -403,6 +486,7 @@ public:
     // kickers sorted in decreasing rank.
     // Else return an empty vector.
     vector<Card> isThreeOfAKind(int p){
+        populate_community();
         vector<Card> ret;
         vector<Card> three;
         for(int i=13;i>=1;--i){ // Make sure not to count each Ace twice
@@ -450,6 +534,7 @@ public:
     // of the return vector put the highest kicker.
     // Else return an empty vector.
     vector<Card> isTwoPair(int p){
+        populate_community();
         vector<Card> ret;
         vector<Card> two1;
         vector<Card> two2;
@@ -513,6 +598,7 @@ public:
     // the return vector put the highest kickers in decreasing rank order.
     // Else return an empty vector.
     vector<Card> isPair(int p){
+        populate_community();
         vector<Card> ret;
         vector<Card> two;
         for(int i=13;i>=1;--i){ // Make sure not to count each Ace twice
@@ -560,6 +646,7 @@ public:
     // Put the cards in decreasing rank order.
     // Else return an empty vector.
     vector<Card> highCard(int p){
+        populate_community();
         vector<Card> ret;
         for(int i=13;i>=1&&ret.size()<5;--i){ // Make sure not to count each Ace twice
             for(int j=0;j<4&&ret.size()<5;++j){
@@ -575,118 +662,111 @@ public:
         return ret;
     }
     
+    // Return the suit masks (see HandEvaluator.h) of the cards player p
+    // can claim.
+    array<int,4> suit_masks(int p){
+        array<int,4> masks=board.get_suit_masks();
+        for(int i=0;i<4;++i)
+            masks[i]|=hole_masks[p][i];
+        return masks;
+    }
+    
+    // Return score of the best hand for player p (see HandEvaluator.h).
+    // Only the pocket cards of player p are folded into the analysis of
+    // the community cards, which is shared by all the players.
+    int hand_score(int p){
+        return board.score_with(hole_masks[p]);
+    }
+    
+    // Analysis of the community cards (see BoardSummary.h).
+    const BoardSummary & get_board() const{
+        return board;
+    }
+    
+    // Classify the best hand of player p without building its Cards.
+    HandResult classify(int p){
+        return HandResult(this,p,hand_score(p));
+    }
+    
+    // Return the best hand of player p, which is known to be of the given
+    // rank, by running the checker of that rank.
+    vector<Card> hand_of_rank(int p,int rank){
+        switch(rank){
+            case 8: return isStraightFlush(p);
+            case 7: return isFourOfAKind(p);
+            case 6: return isFullHouse(p);
+            case 5: return isFlush(p);
+            case 4: return isStraight(p);
+            case 3: return isThreeOfAKind(p);
+            case 2: return isTwoPair(p);
+            case 1: return isPair(p);
+            default: return highCard(p);
+        }
+    }
+    
     // Return rank of the best hand for player p.
     int bestHand_rank(int p){
-        vector<Card> res;
-        res=isStraightFlush(p);
-        if(res.size()>0)
-            return 8;
-        res=isFourOfAKind(p);
-        if(res.size()>0)
-            return 7;
-        res=isFullHouse(p);
-        if(res.size()>0)
-            return 6;
-        res=isFlush(p);
-        if(res.size()>0)
-            return 5;
-        res=isStraight(p);
-        if(res.size()>0)
-            return 4;
-        res=isThreeOfAKind(p);
-        if(res.size()>0)
-            return 3;
-        res=isTwoPair(p);
-        if(res.size()>0)
-            return 2;
-        res=isPair(p);
-        if(res.size()>0)
-            return 1;
-        return 0;
+        return HandEvaluator::category(hand_score(p));
     }
     
     // Return best hand of player p.
     vector<Card> bestHand(int p){
-        vector<Card> res;
-        res=isStraightFlush(p);
-        if(res.size()>0)
-            return res;
-        res=isFourOfAKind(p);
-        if(res.size()>0)
-            return res;
-        res=isFullHouse(p);
-        if(res.size()>0)
-            return res;
-        res=isFlush(p);
-        if(res.size()>0)
-            return res;
-        res=isStraight(p);
-        if(res.size()>0)
-            return res;
-        res=isThreeOfAKind(p);
-        if(res.size()>0)
-            return res;
-        res=isTwoPair(p);
-        if(res.size()>0)
-            return res;
-        res=isPair(p);
-        if(res.size()>0)
-            return res;
-        res=highCard(p);
-        return res;
+        return classify(p).cards();
     }
     
     // Returns vector of winning players.
     vector<int> winning_players(){
-        int highest_hand_rank=-1;
-        for(int i=0;i<players.size();++i){
-            int p=players[i];
-            int rank=bestHand_rank(p);
-            if(rank>highest_hand_rank)
-                highest_hand_rank=rank;
-            players_cards_vector[p]=bestHand(p);
-        }
+        int highest_score=-1;
         vector<int> winning_players;
         for(int i=0;i<players.size();++i){
             int p=players[i];
-            int rank=bestHand_rank(p);
-            if(rank==highest_hand_rank){
-                winning_players.push_back(p);
+            int score=hand_score(p);
+            if(score>highest_score){
+                highest_score=score;
+                winning_players={};
             }
+            if(score==highest_score)
+                winning_players.push_back(p);
         }
-        if(winning_players.size()==1)
-            return winning_players;
-        for(int i=0;i<5;++i){
-            int highest=-1;
-            for(int j=0;j<winning_players.size();++j){
-                int p=winning_players[j];
-                string rank=players_cards_vector[p][i].rank;
-                int r;
-                if(rank=="A")
-                    r=13;
-                else
-                    r=rank_to_index[rank];
-                if(r>highest)
-                    highest=r;
+        return winning_players;
+    }
+    
+    // Returns the winners of the high and the low halves of the pot in the
+    // Hi-Lo (8-or-better) game. The high and the low hand of each player are
+    // found in one pass.
+    HiLoWinners winning_players_hilo(){
+        HiLoWinners winners;
+        int highest_score=-1;
+        int highest_low=0;
+        for(int i=0;i<players.size();++i){
+            int p=players[i];
+            int low;
+            int score=board.score_with(hole_masks[p],&low);
+            if(score>highest_score){
+                highest_score=score;
+                winners.high={};
             }
-            vector<int> candidates;
-            for(int j=0;j<winning_players.size();++j){
-                int p=winning_players[j];
-                string rank=players_cards_vector[p][i].rank;
-                int r;
-                if(rank=="A")
-                    r=13;
-                else
-                    r=rank_to_index[rank];
-                if(r==highest)
-                    candidates.push_back(p);
+            if(score==highest_score)
+                winners.high.push_back(p);
+            if(low>highest_low){
+                highest_low=low;
+                winners.low={};
             }
-            if(candidates.size()==1)
-                return candidates;
-            else
-                winning_players=candidates;
+            if(low>0&&low==highest_low)
+                winners.low.push_back(p);
         }
-        return winning_players;
+        if(winners.high.size()==1&&(winners.low.size()==0
+                                    ||winners.low==winners.high))
+            winners.scoops=winners.high;
+        return winners;
+    }
+    
+    // Return score of the best 8-or-better low hand for player p, 0 if the
+    // player has no qualifying low (see HandEvaluator.h).
+    int low_score(int p){
+        int low;
+        board.score_with(hole_masks[p],&low);
+        return low;
     }
     
 private:
@@ -697,6 +777,17 @@ private:
     map<int,char> index_to_suit;
     vector<int> players;
     map<int,vector<vector<int>>> players_cards;
-    map<int,vector<Card>> players_cards_vector;
+    map<int,array<int,4>> hole_masks;
+    vector<Card> community_cards;
+    bool community_populated;
+    BoardSummary board;
     
 };
+
+inline const vector<Card> & HandResult::cards(){
+    if(!materialized){
+        hand=checkset->hand_of_rank(player,category());
+        materialized=true;
+    }
+    return hand;
+}
@@ -0,0 +1,153 @@
+/********************************************************************************
+
+            Enumeration of k-element subsets in revolving-door order.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The k-element subsets of {0,...,n-1} (e.g. positions in the vector of the cards
+ remaining in the deck) are visited in the revolving-door Gray code order, in
+ which two consecutive subsets differ by exactly one element: one element leaves
+ the subset and one enters it. Together with IncrementalHand this updates the
+ hand with one removed and one added card per step, instead of rebuilding the
+ hand for every subset.
+
+ The order is defined recursively: the subsets of {0,...,n-1} are the subsets of
+ {0,...,n-2}, followed by the subsets of {0,...,n-2} of k-1 elements in reverse
+ order, each with the element n-1 added. The subsets are numbered by their
+ position 0,...,C(n,k)-1 in this order, and unrank() returns the subset at the
+ given position. The walker can visit any range of positions, so that the
+ enumeration is split between threads with split().
+
+ The steps are the ones of the Algorithm R of D. Knuth, The Art of Computer
+ Programming, Vol. 4A, 7.2.1.3.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+class CombinationWalker{
+
+public:
+
+    // Walker over the positions begin,...,end-1 of the k-element subsets
+    // of {0,...,n-1}, starting at the subset at position begin < end.
+    CombinationWalker(int n_elements,int k_elements,uint64_t begin,uint64_t end) :
+        n(n_elements), k(k_elements), position(begin), last(end){
+        combination=unrank(n,k,begin);
+        c.assign(k+2,0);
+        for(int j=1;j<=k;++j)
+            c[j]=combination[j-1];
+        c[k+1]=n;
+    }
+
+    // Walker over all the k-element subsets of {0,...,n-1}.
+    CombinationWalker(int n_elements,int k_elements) :
+        CombinationWalker(n_elements,k_elements,0,binomial(n_elements,k_elements)) {};
+
+    // Current subset, its elements in increasing order.
+    const vector<int> & get_combination() const{
+        return combination;
+    }
+
+    // Position of the current subset.
+    uint64_t get_position() const{
+        return position;
+    }
+
+    // Go to the next subset. The element which left the subset is saved in
+    // out and the element which entered it in in. Return false, without
+    // changing the subset, if the current subset is the last in the range.
+    bool next(int & out,int & in){
+        if(position+1>=last)
+            return false;
+        ++position;
+        // Steps R3-R5 of Algorithm R.
+        if(k%2==1&&c[1]+1<c[2]){
+            out=c[1];
+            in=c[1]+1;
+            set(1,in);
+            return true;
+        }
+        if(k%2==0&&c[1]>0){
+            out=c[1];
+            in=c[1]-1;
+            set(1,in);
+            return true;
+        }
+        bool decrease= k%2==1;
+        for(int j=2;j<=k;++j){
+            if(decrease&&c[j]>=j){ // Here c[j]=c[j-1]+1.
+                out=c[j];
+                in=j-2;
+                set(j,c[j-1]);
+                set(j-1,in);
+                return true;
+            }
+            if(!decrease&&c[j]+1<c[j+1]){ // Here c[j-1]=j-2.
+                out=c[j-1];
+                in=c[j]+1;
+                set(j-1,c[j]);
+                set(j,in);
+                return true;
+            }
+            decrease=!decrease;
+        }
+        return false;
+    }
+
+    // Binomial coefficient C(n,k).
+    static uint64_t binomial(int n,int k){
+        if(k<0||k>n)
+            return 0;
+        uint64_t b=1;
+        for(int i=1;i<=k;++i)
+            b=b*(n-k+i)/i;
+        return b;
+    }
+
+    // Return the subset at the given position, in increasing order.
+    static vector<int> unrank(int n,int k,uint64_t position){
+        vector<int> subset;
+        for(int m=n;k>0;--m){
+            if(k==m){ // The only subset is {0,...,m-1}.
+                for(int i=m-1;i>=0;--i)
+                    subset.push_back(i);
+                break;
+            }
+            uint64_t without=binomial(m-1,k);
+            if(position>=without){
+                subset.push_back(m-1);
+                position=binomial(m-1,k-1)-1-(position-without);
+                --k;
+            }
+        }
+        reverse(subset.begin(),subset.end());
+        return subset;
+    }
+
+    // Split the positions 0,...,total-1 into the given number of ranges
+    // [begin,end) of nearly equal length.
+    static vector<pair<uint64_t,uint64_t>> split(uint64_t total,int parts){
+        vector<pair<uint64_t,uint64_t>> ranges;
+        for(int i=0;i<parts;++i)
+            ranges.push_back(make_pair(total*i/parts,total*(i+1)/parts));
+        return ranges;
+    }
+
+private:
+
+    int n;
+    int k;
+    uint64_t position;
+    uint64_t last;
+    vector<int> combination;
+    vector<int> c; // c[1],...,c[k] is the subset, c[k+1]=n, as in Algorithm R.
+
+    void set(int j,int value){
+        c[j]=value;
+        combination[j-1]=value;
+    }
+
+};
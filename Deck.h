@@ -11,6 +11,9 @@
  Returning discarded cards to the deck can be done by setting "pointer"
  back to zero and calling "shuffle()" to the deck, which is wrapped into
  reset() method.
+
+ The deck is a template over the rules of the variant (see DeckRules.h), which
+ define the ranks in the deck. Deck is the standard 52-card deck.
  
                     %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
  
@@ -18,18 +21,20 @@
 
 using namespace std;
 
-class Deck{
+template<class Rules>
+class BasicDeck{
     
 public:
     
-    Deck(){
+    BasicDeck(){
         cards={};
         order={};
-        for(int i=0;i<52;++i)
+        for(int i=0;i<Rules::deck_size;++i)
             order[i]=i;
         vector<char> suits={'H','D','S','C'};
-        vector<string> ranks={"2","3","4","5","6","7","8",
-                              "9","10","J","Q","K","A"};
+        vector<string> ranks;
+        for(int i=0;i<Rules::n_ranks;++i)
+            ranks.push_back(Rules::rank_name(i));
         for(auto r : ranks){
             for(auto s : suits){
                 int p=0;
@@ -69,7 +74,7 @@ public:
     vector<Card> get_cards(){
         return cards;
     }
-    array<int,52> get_order(){
+    array<int,Rules::deck_size> get_order(){
         return order;
     }
     int get_pointer(){
@@ -79,7 +84,9 @@ public:
 private:
     
     vector<Card> cards;
-    array<int,52> order;
+    array<int,Rules::deck_size> order;
     int pointer;
     
 };
+
+typedef BasicDeck<StandardRules> Deck;
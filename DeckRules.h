@@ -0,0 +1,98 @@
+/********************************************************************************
+
+                    Rules of the poker variants played with
+                        the different decks of cards.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The rules are compile-time parameters of BasicHandEvaluator (HandEvaluator.h)
+ and BasicDeck (Deck.h), so that each variant gets its own evaluator without
+ branching on the variant at run time. The ranks are described by the columns
+ of the CheckSet table: Ace is in the columns 0 and 13, "2",...,"K" are in the
+ columns 1,...,12.
+
+ Each rules class provides:
+
+ n_ranks -- number of ranks in the deck.
+ deck_size -- number of cards in the deck.
+ rank_name(i) -- name of the i-th lowest rank of the deck, i=0,...,n_ranks-1.
+ ranks_mask -- mask of the columns 1,...,13 of the ranks in the deck, from which
+               BasicHandEvaluator counts the cards and picks the kickers.
+ n_straights -- number of distinct straights.
+ straight(i) -- mask of the five columns of the i-th straight, i=0,...,
+                n_straights-1. The low straights use the Ace in column 0.
+ straight_high(i) -- column of the highest card of the i-th straight.
+ strength(c) -- strength of the hand ranking c (0 -- High Card, ...,
+                8 -- Straight Flush, as in CheckSet), which orders the hands.
+ category(s) -- the hand ranking of the strength s, the inverse of strength().
+
+ The strengths may differ from the hand ranking only by exchanging Flush with
+ Full House and Straight with Three of a Kind, which are the two pairs of
+ hands resolved by BasicHandEvaluator in both orders.
+
+ StandardRules -- 52-card deck, Ace-low straight A-2-3-4-5.
+ ShortDeckRules -- 36-card Short Deck (6+): the ranks 2, 3, 4, 5 are removed,
+                   A-6-7-8-9 is the lowest straight, Flush beats Full House.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+struct StandardRules{
+
+    static const int n_ranks=13;
+    static const int deck_size=52;
+    static const int ranks_mask=0x3FFE;
+    static const int n_straights=10;
+
+    static string rank_name(int i){
+        static const string names[n_ranks]={"2","3","4","5","6","7","8",
+                                            "9","10","J","Q","K","A"};
+        return names[i];
+    }
+    static int straight(int i){
+        return 0x1F<<i; // Columns i,...,i+4, i=0 being the wheel A-2-3-4-5.
+    }
+    static int straight_high(int i){
+        return i+4;
+    }
+    static int strength(int c){
+        return c;
+    }
+    static int category(int s){
+        return s;
+    }
+
+};
+
+struct ShortDeckRules{
+
+    static const int n_ranks=9;
+    static const int deck_size=36;
+    static const int ranks_mask=0x3FE0;
+    static const int n_straights=6;
+
+    static string rank_name(int i){
+        static const string names[n_ranks]={"6","7","8","9","10",
+                                            "J","Q","K","A"};
+        return names[i];
+    }
+    static int straight(int i){
+        if(i==0)
+            return 1|0xF<<5; // A-6-7-8-9, Ace in column 0.
+        return 0x1F<<(i+4);
+    }
+    static int straight_high(int i){
+        return i+8;
+    }
+    static int strength(int c){
+        static const int strengths[9]={0,1,2,3,4,6,5,7,8};
+        return strengths[c];
+    }
+    static int category(int s){
+        return strength(s); // The exchange of Flush and Full House is its own inverse.
+    }
+
+};
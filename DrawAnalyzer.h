@@ -0,0 +1,249 @@
+/********************************************************************************
+
+                Best discard in the five-card draw (video poker).
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Given five dealt cards (card indexes, see HandEvaluator.h), there are 32 choices
+ of the cards to hold, coded as a 5-bit mask: bit i is set if the dealt card i is
+ held. For every choice the discarded cards are replaced from the 47 cards left
+ in the deck, and the analyzer finds the distribution of the final hand ranking
+ (0 -- High Card, ..., 8 -- Straight Flush, as in CheckSet) and the expected
+ value of the final hand under the paytable.
+
+ The exact search visits all the draws of every choice, 2,598,960 five-card hands
+ in total, in revolving-door order (see CombinationWalker.h): the final hand is
+ updated by one card per draw and scored with HandEvaluator. The draws of every
+ choice are split between the threads. Alternatively, a given number of random
+ draws per choice is sampled.
+
+ The result of the exact search depends only on the dealt hand up to the renaming
+ of the suits, so the 2,598,960 deals have only 134,459 distinct results. The
+ analyzer keeps the results of the exact searches by the form of the dealt hand
+ with the suits renamed to the smallest set of card indexes, so that a strategy
+ table over all the deals runs the exact search once per distinct result. The
+ cache takes about 3 kB per distinct dealt hand, clear_cache() releases it.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+// Payouts of the final hands per unit bet.
+struct DrawPaytable{
+    array<double,9> payout; // Payout of each hand ranking.
+    double royal_flush; // Payout of the Ace-high Straight Flush.
+    int min_pair; // Lowest column of a One Pair which is paid.
+
+    // Full-pay Jacks or Better (9/6).
+    static DrawPaytable jacks_or_better(){
+        DrawPaytable table;
+        table.payout={0,1,2,3,4,6,9,25,50};
+        table.royal_flush=800;
+        table.min_pair=10; // "J"
+        return table;
+    }
+
+    // Payout of the hand with the given score (see HandEvaluator.h).
+    double pay(int score) const{
+        int c=HandEvaluator::category(score);
+        if(c==1&&HandEvaluator::rank_at(score,0)<min_pair)
+            return 0;
+        if(c==8&&HandEvaluator::rank_at(score,0)==13)
+            return royal_flush;
+        return payout[c];
+    }
+};
+
+// Result of one choice of the cards to hold.
+struct DrawOption{
+    int hold; // Bit i is set if the dealt card i is held.
+    array<double,9> distribution; // Probability of each final hand ranking.
+    double expected_value;
+};
+
+class DrawAnalyzer{
+
+public:
+
+    DrawAnalyzer(const DrawPaytable & table=DrawPaytable::jacks_or_better(),int n_threads=1) :
+        paytable(table), threads(n_threads) {};
+
+    // Return the results of all the 32 choices for the dealt cards, indexed by
+    // the hold mask. If samples is 0 the search is exact, otherwise samples
+    // random draws are dealt per choice.
+    vector<DrawOption> analyze(const vector<int> & dealt,uint64_t samples=0){
+        array<int,5> canonical;
+        array<int,5> position;
+        uint64_t key=canonical_form(dealt,canonical,position);
+        vector<DrawOption> options;
+        auto found=cache.find(key);
+        if(samples==0&&found!=cache.end())
+            options=found->second;
+        else{
+            options=search(canonical,samples);
+            if(samples==0)
+                cache[key]=options;
+        }
+        vector<DrawOption> ret(32);
+        for(int hold=0;hold<32;++hold){
+            int h=0;
+            for(int i=0;i<5;++i){
+                if(hold>>i&1)
+                    h|=1<<position[i];
+            }
+            ret[hold]=options[h];
+            ret[hold].hold=hold;
+        }
+        return ret;
+    }
+
+    // Return the choice with the highest expected value.
+    DrawOption best(const vector<int> & dealt,uint64_t samples=0){
+        vector<DrawOption> options=analyze(dealt,samples);
+        return *max_element(options.begin(),options.end(),
+                            [](const DrawOption & a,const DrawOption & b){
+                                return a.expected_value<b.expected_value;
+                            });
+    }
+
+    void clear_cache(){
+        cache.clear();
+    }
+
+private:
+
+    DrawPaytable paytable;
+    int threads;
+    map<uint64_t,vector<DrawOption>> cache;
+
+    // Counts of the final hand rankings and the sum of the payouts
+    // of one choice.
+    struct Tally{
+        array<double,9> counts;
+        double payout;
+        uint64_t draws;
+    };
+
+    // Rename the suits of the dealt cards so that the set of their indexes is
+    // the smallest, and return it as the key. The renamed cards are saved in
+    // canonical in increasing order, position[i] is the position of the dealt
+    // card i in canonical.
+    static uint64_t canonical_form(const vector<int> & dealt,array<int,5> & canonical,array<int,5> & position){
+        array<int,4> perm={0,1,2,3};
+        uint64_t key=~0ULL;
+        array<int,4> best_perm=perm;
+        do{
+            uint64_t k=0;
+            for(int c : dealt)
+                k|=1ULL<<(13*perm[c/13]+c%13);
+            if(k<key){
+                key=k;
+                best_perm=perm;
+            }
+        }while(next_permutation(perm.begin(),perm.end()));
+        for(int i=0;i<5;++i)
+            canonical[i]=13*best_perm[dealt[i]/13]+dealt[i]%13;
+        sort(canonical.begin(),canonical.end());
+        for(int i=0;i<5;++i){
+            int c=13*best_perm[dealt[i]/13]+dealt[i]%13;
+            position[i]=find(canonical.begin(),canonical.end(),c)-canonical.begin();
+        }
+        return key;
+    }
+
+    vector<DrawOption> search(const array<int,5> & dealt,uint64_t samples){
+        vector<int> deck;
+        for(int c=0;c<52;++c){
+            if(find(dealt.begin(),dealt.end(),c)==dealt.end())
+                deck.push_back(c);
+        }
+        vector<vector<Tally>> tallies(threads,vector<Tally>(32,Tally{{},0,0}));
+        auto work=[&](int t){
+            if(samples==0)
+                enumerate(dealt,deck,t,tallies[t]);
+            else
+                sample(dealt,deck,samples*(t+1)/threads-samples*t/threads,t,tallies[t]);
+        };
+        if(threads<=1)
+            work(0);
+        else{
+            vector<thread> workers;
+            for(int t=0;t<threads;++t)
+                workers.push_back(thread(work,t));
+            for(thread & w : workers)
+                w.join();
+        }
+        vector<DrawOption> options(32);
+        for(int hold=0;hold<32;++hold){
+            Tally total={{},0,0};
+            for(int t=0;t<threads;++t){
+                for(int c=0;c<9;++c)
+                    total.counts[c]+=tallies[t][hold].counts[c];
+                total.payout+=tallies[t][hold].payout;
+                total.draws+=tallies[t][hold].draws;
+            }
+            options[hold].hold=hold;
+            for(int c=0;c<9;++c)
+                options[hold].distribution[c]=total.counts[c]/total.draws;
+            options[hold].expected_value=total.payout/total.draws;
+        }
+        return options;
+    }
+
+    // Visit the share t of the draws of every choice.
+    void enumerate(const array<int,5> & dealt,const vector<int> & deck,int t,vector<Tally> & tally) const{
+        for(int hold=0;hold<32;++hold){
+            int k=5-__builtin_popcount(hold);
+            uint64_t total=CombinationWalker::binomial(deck.size(),k);
+            pair<uint64_t,uint64_t> range=CombinationWalker::split(total,threads)[t];
+            if(range.first==range.second)
+                continue;
+            IncrementalHand hand=held_cards(dealt,hold);
+            CombinationWalker walker(deck.size(),k,range.first,range.second);
+            for(int i : walker.get_combination())
+                hand.add(deck[i]);
+            int out,in;
+            do{
+                record(hand.score(),tally[hold]);
+                if(!walker.next(out,in))
+                    break;
+                hand.swap(deck[out],deck[in]);
+            }while(true);
+        }
+    }
+
+    // Deal n random draws for every choice.
+    void sample(const array<int,5> & dealt,vector<int> deck,uint64_t n,int t,vector<Tally> & tally) const{
+        mt19937_64 generator(chrono::system_clock::now().time_since_epoch().count()+t);
+        for(int hold=0;hold<32;++hold){
+            int k=5-__builtin_popcount(hold);
+            for(uint64_t s=0;s<n;++s){
+                IncrementalHand hand=held_cards(dealt,hold);
+                for(int i=0;i<k;++i){
+                    uniform_int_distribution<int> pick(i,deck.size()-1);
+                    swap(deck[i],deck[pick(generator)]);
+                    hand.add(deck[i]);
+                }
+                record(hand.score(),tally[hold]);
+            }
+        }
+    }
+
+    static IncrementalHand held_cards(const array<int,5> & dealt,int hold){
+        IncrementalHand hand;
+        for(int i=0;i<5;++i){
+            if(hold>>i&1)
+                hand.add(dealt[i]);
+        }
+        return hand;
+    }
+
+    void record(int score,Tally & tally) const{
+        tally.counts[HandEvaluator::category(score)]+=1;
+        tally.payout+=paytable.pay(score);
+        ++tally.draws;
+    }
+
+};
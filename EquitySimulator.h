@@ -0,0 +1,238 @@
+/********************************************************************************
+
+        Monte Carlo equity of Hold'em players with variance reduction.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Given the pocket cards of the players, the community cards dealt so far and the
+ dead cards (all as card indexes, see HandEvaluator.h), the simulator deals the
+ rest of the community cards ("runouts") and finds the equity of each player:
+ the expected share of the pot, with the split pots shared equally.
+
+ Two methods reduce the number of the runouts needed for the given precision,
+ compared to dealing a fixed number of random runouts:
+
+ Exact enumeration -- if there are at most exact_limit runouts (e.g. on the flop
+ and on the turn), all of them are visited once in revolving-door order (see
+ CombinationWalker.h), updating the community cards by one card per runout.
+ The result is exact and the error is zero.
+
+ Balanced sweeps -- otherwise the runouts are dealt in sweeps. A sweep shuffles
+ the cards remaining in the deck and splits them into consecutive runouts, so
+ that every card is dealt exactly once per sweep (up to the last R mod k cards,
+ where k is the number of missing community cards). Each runout is a uniformly
+ random runout, but the effect of each single card on the equity is balanced
+ within the sweep, which removes its contribution to the variance. For a
+ three-way pre-flop all-in this needs about 1.5 times fewer runouts than
+ independent random dealing.
+
+ Every sweep is an unbiased estimate of the equities, independent from the other
+ sweeps, so the confidence interval of the equity is found from the variance of
+ the sweep averages. simulate() deals sweeps until the half-width of the interval
+ of every player is below the requested precision, instead of a fixed number of
+ trials, and reports the number of the runouts evaluated and the achieved error.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+// Result of EquitySimulator::simulate().
+struct EquityReport{
+    vector<double> equity; // Equity of each player, in the order of the players.
+    vector<double> error; // Half-width of the confidence interval of the equity.
+    uint64_t trials; // Number of runouts evaluated.
+    bool converged; // The requested precision was reached.
+};
+
+class EquitySimulator{
+
+public:
+
+    // Minimal number of sweeps before the variance is trusted.
+    static const int min_sweeps=10;
+    // Maximal number of runouts which are enumerated exactly.
+    static const int exact_limit=20000;
+
+    // pockets[i] are the pocket cards of the player i, board are the community
+    // cards dealt so far, dead are the cards known to be out of the deck.
+    EquitySimulator(const vector<vector<int>> & pockets,const vector<int> & board,
+                    const vector<int> & dead,uint64_t seed) : generator(seed){
+        uint64_t used=0;
+        for(const vector<int> & pocket : pockets){
+            array<int,4> masks={};
+            for(int c : pocket){
+                HandEvaluator::add_card(masks,c);
+                used|=1ULL<<c;
+            }
+            hole_masks.push_back(masks);
+        }
+        board_masks={};
+        for(int c : board){
+            HandEvaluator::add_card(board_masks,c);
+            used|=1ULL<<c;
+        }
+        for(int c : dead)
+            used|=1ULL<<c;
+        for(int c=0;c<52;++c){
+            if(!(used>>c&1))
+                deck.push_back(c);
+        }
+        missing=5-board.size();
+        exact=CombinationWalker::binomial(deck.size(),missing)<=exact_limit;
+    }
+
+    // Number of runouts in a sweep.
+    int get_strata() const{
+        if(exact)
+            return CombinationWalker::binomial(deck.size(),missing);
+        return deck.size()/missing;
+    }
+
+    // Deal one sweep of runouts, calling on_runout(scores) for each of them,
+    // where scores[i] is the score (see HandEvaluator.h) of the player i.
+    template<class F>
+    void sweep(F on_runout){
+        vector<int> scores(hole_masks.size());
+        if(exact){
+            CombinationWalker walker(deck.size(),missing);
+            IncrementalHand runout(board_masks);
+            for(int i : walker.get_combination())
+                runout.add(deck[i]);
+            int out,in;
+            do{
+                score_players(runout.get_suit_masks(),scores);
+                on_runout(scores);
+                if(!walker.next(out,in))
+                    break;
+                runout.swap(deck[out],deck[in]);
+            }while(true);
+            return;
+        }
+        shuffle(deck.begin(),deck.end(),generator);
+        for(int s=0;s+missing<=deck.size();s+=missing){
+            array<int,4> masks=board_masks;
+            for(int t=s;t<s+missing;++t)
+                HandEvaluator::add_card(masks,deck[t]);
+            score_players(masks,scores);
+            on_runout(scores);
+        }
+    }
+
+    // Estimate the equities to the given precision (e.g. 0.001 for +-0.1%)
+    // at the given confidence level, dealing at most max_trials runouts.
+    EquityReport simulate(double precision,double confidence=0.95,uint64_t max_trials=100000000){
+        return estimate(hole_masks.size(),add_shares,precision,confidence,max_trials);
+    }
+
+    // Add the share of the pot won by each player with the scores to share,
+    // the split pots shared equally.
+    static void add_shares(const vector<int> & scores,vector<double> & share){
+        int highest=*max_element(scores.begin(),scores.end());
+        int n_winners=count(scores.begin(),scores.end(),highest);
+        for(int i=0;i<scores.size();++i){
+            if(scores[i]==highest)
+                share[i]+=1.0/n_winners;
+        }
+    }
+
+    // Estimate the expectations of n quantities with the stopping rule of
+    // simulate(). For each runout, outcome(scores,values) adds the values of
+    // the quantities to values[0],...,values[n-1]. The expectations are saved
+    // in the equity of the report.
+    template<class F>
+    EquityReport estimate(int n,F outcome,double precision,double confidence=0.95,uint64_t max_trials=100000000){
+        return estimate_sweeps(n,get_strata(),exact,SweepDealer{this},
+                               outcome,precision,confidence,max_trials);
+    }
+
+    // The stopping rule of simulate() for any dealer of independent sweeps:
+    // deal_sweep(on_runout) deals a sweep of the given number of runouts
+    // (strata), calling on_runout(scores) for each of them, and
+    // outcome(scores,values) adds the values of the n quantities of the
+    // runout to values. If exact, a single sweep visits all the runouts.
+    template<class S,class F>
+    static EquityReport estimate_sweeps(int n,int strata,bool exact,S deal_sweep,F outcome,
+                                        double precision,double confidence,uint64_t max_trials){
+        double z=normal_quantile(0.5+confidence/2);
+        vector<double> sum(n,0), sum_sq(n,0), values(n);
+        EquityReport report;
+        report.equity.assign(n,0);
+        report.error.assign(n,0);
+        report.trials=0;
+        report.converged=false;
+        for(int sweeps=1;;++sweeps){
+            fill(values.begin(),values.end(),0.0);
+            deal_sweep(Tally<F>{outcome,values});
+            report.trials+=strata;
+            double max_error=0;
+            for(int i=0;i<n;++i){
+                double m=values[i]/strata;
+                sum[i]+=m;
+                sum_sq[i]+=m*m;
+                report.equity[i]=sum[i]/sweeps;
+                if(sweeps>1){
+                    double var=max(0.0,(sum_sq[i]-sum[i]*sum[i]/sweeps)/(sweeps-1));
+                    report.error[i]=z*sqrt(var/sweeps);
+                }
+                max_error=max(max_error,report.error[i]);
+            }
+            if(exact||(sweeps>=min_sweeps&&max_error<=precision)){
+                report.converged=true;
+                break;
+            }
+            if(report.trials+strata>max_trials)
+                break;
+        }
+        return report;
+    }
+
+    // Quantile of the standard normal distribution, with absolute error below
+    // 4.5e-4 (Abramowitz and Stegun, 26.2.23).
+    static double normal_quantile(double p){
+        if(p<0.5)
+            return -normal_quantile(1-p);
+        double t=sqrt(-2*log(1-p));
+        return t-(2.515517+0.802853*t+0.010328*t*t)
+                /(1+1.432788*t+0.189269*t*t+0.001308*t*t*t);
+    }
+
+private:
+
+    // Calls sweep() of the simulator, for estimate_sweeps().
+    struct SweepDealer{
+        EquitySimulator * simulator;
+        template<class G>
+        void operator()(G on_runout) const{
+            simulator->sweep(on_runout);
+        }
+    };
+
+    // Adds the outcome of a runout to the values, for estimate_sweeps().
+    template<class F>
+    struct Tally{
+        F & outcome;
+        vector<double> & values;
+        void operator()(const vector<int> & scores) const{
+            outcome(scores,values);
+        }
+    };
+
+    vector<array<int,4>> hole_masks;
+    array<int,4> board_masks;
+    vector<int> deck;
+    int missing;
+    bool exact;
+    mt19937_64 generator;
+
+    void score_players(const array<int,4> & masks,vector<int> & scores) const{
+        for(int i=0;i<hole_masks.size();++i){
+            array<int,4> m;
+            for(int s=0;s<4;++s)
+                m[s]=masks[s]|hole_masks[i][s];
+            scores[i]=HandEvaluator::score(m);
+        }
+    }
+
+};
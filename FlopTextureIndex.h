@@ -0,0 +1,166 @@
+/********************************************************************************
+
+                    Texture of all the 22,100 possible flops.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The features of a flop used for bucketing and reporting are found once for all
+ the flops and looked up in O(1) from the three community cards (card indexes,
+ see HandEvaluator.h).
+
+ Two flops which differ only by renaming the suits have the same features, so
+ the features are stored once per class of such flops: 1,755 classes of the
+ 22,100 flops. The flop with the cards a < b < c has the number
+ C(c,3) + C(b,2) + a in 0,...,22099, which indexes the table of the classes.
+
+ The features of the flop (FlopTexture) are:
+
+ paired -- at least two cards of the same rank (trips included).
+ trips -- three cards of the same rank.
+ monotone, two_tone, rainbow -- three, two or one suits on the flop.
+ connectedness -- distance between the highest and the lowest distinct ranks
+                  (Ace counted high or low, whichever is smaller), 0 for trips.
+ straight_possible -- two pocket cards can make a straight.
+ flush_possible -- two pocket cards can make a flush (monotone flop).
+ flush_draw -- two suited pocket cards make at least a flush draw, four cards
+               of a suit (two-tone or monotone flop). A single pocket card
+               does so only on the monotone flop.
+ category -- ranking of the best hand of the flop cards only, as in CheckSet.
+ score -- score of that hand (see HandEvaluator.h).
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+struct FlopTexture{
+    bool paired;
+    bool trips;
+    bool monotone;
+    bool two_tone;
+    bool rainbow;
+    int connectedness;
+    bool straight_possible;
+    bool flush_possible;
+    bool flush_draw;
+    int category;
+    int score;
+};
+
+class FlopTextureIndex{
+
+public:
+
+    static const int n_flops=22100;
+
+    // Build the index of all the flops.
+    FlopTextureIndex(){
+        for(int n=0;n<52;++n){
+            choose2[n]=n*(n-1)/2;
+            choose3[n]=n*(n-1)*(n-2)/6;
+        }
+        flop_class.assign(n_flops,0);
+        map<uint64_t,int> classes;
+        for(int c=2;c<52;++c){
+            for(int b=1;b<c;++b){
+                for(int a=0;a<b;++a){
+                    uint64_t key=canonical_key(a,b,c);
+                    auto found=classes.find(key);
+                    if(found==classes.end()){
+                        found=classes.insert(make_pair(key,int(textures.size()))).first;
+                        textures.push_back(texture(a,b,c));
+                    }
+                    flop_class[flop_index(a,b,c)]=found->second;
+                }
+            }
+        }
+    }
+
+    // The index shared by all the users, built at the first call.
+    static const FlopTextureIndex & shared(){
+        static const FlopTextureIndex index;
+        return index;
+    }
+
+    // Return the texture of the flop with the cards c0, c1, c2 (any order).
+    const FlopTexture & lookup(int c0,int c1,int c2) const{
+        return textures[class_of(c0,c1,c2)];
+    }
+
+    // Return the class 0,...,get_classes()-1 of the flop.
+    int class_of(int c0,int c1,int c2) const{
+        if(c0>c1)
+            swap(c0,c1);
+        if(c1>c2)
+            swap(c1,c2);
+        if(c0>c1)
+            swap(c0,c1);
+        return flop_class[flop_index(c0,c1,c2)];
+    }
+
+    // Return the texture of the class.
+    const FlopTexture & get_texture(int flop_class) const{
+        return textures[flop_class];
+    }
+
+    int get_classes() const{
+        return textures.size();
+    }
+
+private:
+
+    array<int,52> choose2;
+    array<int,52> choose3;
+    vector<uint16_t> flop_class;
+    vector<FlopTexture> textures;
+
+    int flop_index(int a,int b,int c) const{
+        return choose3[c]+choose2[b]+a;
+    }
+
+    // Smallest set of the card indexes of the flop over the renamings
+    // of the suits.
+    static uint64_t canonical_key(int a,int b,int c){
+        array<int,4> perm={0,1,2,3};
+        uint64_t key=~0ULL;
+        do{
+            uint64_t k=0;
+            for(int x : {a,b,c})
+                k|=1ULL<<(13*perm[x/13]+x%13);
+            key=min(key,k);
+        }while(next_permutation(perm.begin(),perm.end()));
+        return key;
+    }
+
+    static FlopTexture texture(int a,int b,int c){
+        array<int,4> masks={};
+        for(int x : {a,b,c})
+            HandEvaluator::add_card(masks,x);
+        BoardSummary board(masks);
+        FlopTexture t;
+        int suits=0;
+        for(int i=0;i<4;++i)
+            suits+=board.get_suit_counts()[i]>0;
+        t.monotone= suits==1;
+        t.two_tone= suits==2;
+        t.rainbow= suits==3;
+        t.flush_possible=t.monotone;
+        t.flush_draw=!t.rainbow;
+        int any=masks[0]|masks[1]|masks[2]|masks[3];
+        int ranks=__builtin_popcount(any&HandEvaluator::ranks_mask);
+        t.trips= ranks==1;
+        t.paired= ranks<3;
+        t.straight_possible= ranks==3&&board.get_max_window_ranks()==3;
+        t.connectedness=min(span(any&HandEvaluator::ranks_mask),span(any&0x1FFF));
+        t.score=HandEvaluator::score(masks);
+        t.category=HandEvaluator::category(t.score);
+        return t;
+    }
+
+    // Distance between the highest and the lowest column in the mask.
+    static int span(int mask){
+        return (31-__builtin_clz(mask))-__builtin_ctz(mask);
+    }
+
+};
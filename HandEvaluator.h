@@ -0,0 +1,292 @@
+/********************************************************************************
+
+                Score the best five-card hand from the suit masks.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The cards which player p can claim are summarised by 4 integers, one per suit
+ (in the CheckSet order 'H','S','D','C'). Bit j of a suit mask corresponds to the
+ column j of the 4 x 14 table of CheckSet: Ace is stored twice, in bits 0 and 13,
+ the ranks "2",...,"K" are in bits 1,...,12.
+
+ The score of a hand is a single integer, such that a stronger hand always has a
+ larger score, and equal hands have equal scores:
+
+     score = strength << 20 | r0 << 16 | r1 << 12 | r2 << 8 | r3 << 4 | r4
+
+ where strength is the strength of the hand ranking used in CheckSet (0 -- High
+ Card, ..., 8 -- Straight Flush), and r0,...,r4 are the column indexes of the
+ five cards of the best hand, in the same order in which CheckSet returns them
+ (for example three cards of the set, followed by two kickers). Ace counted low
+ in the wheel straight has index 0. Missing cards (less than five cards dealt)
+ are zeros.
+
+ The evaluator is a template over the rules of the variant (see DeckRules.h),
+ which define the straights and the strength of each hand ranking. The straights
+ are found with the table of the highest straight of each 14-bit mask, which is
+ built once per variant. HandEvaluator is the evaluator of the standard rules,
+ in which the strength is the hand ranking itself.
+
+ No Card objects are built here, which makes the score suitable for the loops
+ which only need the rank of the hand and the winner.
+
+ In Hi-Lo games the best 8-or-better low hand is found together with the high
+ hand, from the columns 0,...,7 of the rank mask, where the Ace is counted low
+ (column 0). The low score is 0 if there is no qualifying low (five distinct
+ ranks from A to 8), otherwise a larger low score is a better low hand.
+
+ For the compact storage of cards a card is also represented by its index
+ 0,...,51: index = 13 * suit + column - 1, so that the cards of suit i are the
+ bits 13 * i,...,13 * i + 12 of a 64-bit set of cards.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+template<class Rules>
+class BasicHandEvaluator{
+
+public:
+
+    // Columns 1,...,13 of the ranks in the deck, i.e. each Ace counted once.
+    static const int ranks_mask=Rules::ranks_mask;
+    // Names of the columns 1,...,13 and of the suits.
+    static const string rank_names[13];
+    static const char suit_names[5];
+
+    // Return the score of the best hand in the suit masks.
+    static int score(const array<int,4> & suit_masks){
+        return score(suit_masks,true,true);
+    }
+
+    // Return the score of the best hand in the suit masks, and save the
+    // score of the best 8-or-better low hand in low.
+    static int score_hi_lo(const array<int,4> & suit_masks,int & low){
+        return score(suit_masks,true,true,&low);
+    }
+
+    // Same as above, but the search for flushes (straights) is skipped if
+    // flush_possible (straight_possible) is false, e.g. when it is known from
+    // the community cards that the player can't have them (see BoardSummary.h).
+    // If low is not null, the low score is found from the same rank mask as
+    // the high hand and saved in low.
+    static int score(const array<int,4> & suit_masks,bool flush_possible,bool straight_possible,int * low=0){
+        int s0=suit_masks[0];
+        int s1=suit_masks[1];
+        int s2=suit_masks[2];
+        int s3=suit_masks[3];
+        int any=s0|s1|s2|s3;
+        if(low)
+            *low=low_table()[any&0xFF];
+        int flush=0;
+        for(int i=0;i<4&&flush_possible;++i){
+            if(__builtin_popcount(suit_masks[i]&ranks_mask)>=5)
+                flush=suit_masks[i];
+        }
+        if(flush){
+            int high=straight_high(flush);
+            if(high)
+                return straight_score(8,high);
+        }
+        int flush_score= flush ? top_score(5,flush&ranks_mask) : -1;
+        int four=s0&s1&s2&s3&ranks_mask;
+        if(four){
+            int r=highest(four);
+            int kicker=highest_or_zero(any&ranks_mask&~(1<<r));
+            return pack(7,r,r,r,r,kicker);
+        }
+        int three=((s0&s1&s2)|(s0&s1&s3)|(s0&s2&s3)|(s1&s2&s3))&ranks_mask;
+        int two=((s0&s1)|(s0&s2)|(s0&s3)|(s1&s2)|(s1&s3)|(s2&s3))&ranks_mask;
+        if(three){
+            int r=highest(three);
+            int pair=two&~(1<<r); // Includes the second three of a kind, if any.
+            if(pair){
+                int q=highest(pair);
+                return max(pack(6,r,r,r,q,q),flush_score);
+            }
+        }
+        if(flush)
+            return flush_score;
+        int three_score=-1;
+        if(three){
+            int r=highest(three);
+            int k[2];
+            top_ranks(any&ranks_mask&~(1<<r),2,k);
+            three_score=pack(3,r,r,r,k[0],k[1]);
+        }
+        int high=straight_possible ? straight_high(any) : 0;
+        if(high)
+            return max(straight_score(4,high),three_score);
+        if(three)
+            return three_score;
+        if(two){
+            int r1=highest(two);
+            int rest=two&~(1<<r1);
+            if(rest){
+                int r2=highest(rest);
+                int kicker=highest_or_zero(any&ranks_mask&~(1<<r1)&~(1<<r2));
+                return pack(2,r1,r1,r2,r2,kicker);
+            }
+            int k[3];
+            top_ranks(any&ranks_mask&~(1<<r1),3,k);
+            return pack(1,r1,r1,k[0],k[1],k[2]);
+        }
+        return top_score(0,any&ranks_mask);
+    }
+
+    // Index of the card of suit suit_i in the column j=1,...,13.
+    static int card_index(int suit_i,int j){
+        return 13*suit_i+j-1;
+    }
+
+    // Index of the Card.
+    static int card_index(const Card & c){
+        int j=find(rank_names,rank_names+13,c.rank)-rank_names+1;
+        return card_index(string(suit_names).find(c.suit),j);
+    }
+
+    // Card with the index card, belonging to player p.
+    static Card card(int card,int p){
+        return Card(rank_names[card%13],suit_names[card/13],p);
+    }
+
+    // Add the card with index card to the suit masks.
+    static void add_card(array<int,4> & suit_masks,int card){
+        int suit_i=card/13;
+        int j=card%13+1;
+        suit_masks[suit_i]|=1<<j;
+        if(j==13)
+            suit_masks[suit_i]|=1;
+    }
+
+    // Remove the card with index card from the suit masks.
+    static void remove_card(array<int,4> & suit_masks,int card){
+        int suit_i=card/13;
+        int j=card%13+1;
+        suit_masks[suit_i]&=~(1<<j);
+        if(j==13)
+            suit_masks[suit_i]&=~1;
+    }
+
+    // Return the suit masks of the 64-bit set of card indexes.
+    static array<int,4> suit_masks(uint64_t cards){
+        array<int,4> masks;
+        for(int i=0;i<4;++i){
+            int m=(cards>>(13*i))&0x1FFF;
+            masks[i]=m<<1|m>>12;
+        }
+        return masks;
+    }
+
+    // Hand ranking (0 -- High Card, ..., 8 -- Straight Flush) of the score.
+    static int category(int score){
+        return Rules::category(score>>20);
+    }
+
+    // Column index of the i-th card (i=0,...,4) of the hand with the score.
+    static int rank_at(int score,int i){
+        return (score>>(16-4*i))&15;
+    }
+
+    // Column index of the highest card of the highest straight in the mask,
+    // or 0 if there is no straight. The wheel straight (Ace counted low)
+    // of the standard rules returns 4, the column of "5".
+    static int straight_high(int mask){
+        return straight_table()[mask&0x3FFF];
+    }
+
+    // Score of the best 8-or-better low hand of the rank mask (see the top of
+    // the file), or 0 if there is no such hand.
+    static int low_score(int mask){
+        return low_table()[mask&0xFF];
+    }
+
+private:
+
+    // Table of low_score() for the columns 0,...,7 of the mask: Ace (counted
+    // low in the column 0), "2",...,"8". The low hand is made of the five lowest
+    // distinct ranks, and it is better if its highest card is lower, then the
+    // next card and so on, which is the order of the 8-bit masks of the five
+    // ranks. The score is 256 minus the mask, so that a better low has a higher
+    // score, as the high hands do.
+    static const array<int,256> & low_table(){
+        static const array<int,256> table=[]{
+            array<int,256> t={};
+            for(int m=0;m<256;++m){
+                int rest=m;
+                int five=0;
+                for(int i=0;i<5&&rest;++i){
+                    int lowest=rest&-rest;
+                    five|=lowest;
+                    rest&=~lowest;
+                }
+                if(__builtin_popcount(five)==5)
+                    t[m]=256-five;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // Table of straight_high() for all the 14-bit masks.
+    static const array<uint8_t,1<<14> & straight_table(){
+        static const array<uint8_t,1<<14> table=[]{
+            array<uint8_t,1<<14> t={};
+            for(int m=0;m<(1<<14);++m){
+                for(int i=0;i<Rules::n_straights;++i){
+                    if((m&Rules::straight(i))==Rules::straight(i))
+                        t[m]=max<int>(t[m],Rules::straight_high(i));
+                }
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    static int pack(int c,int r0,int r1,int r2,int r3,int r4){
+        return Rules::strength(c)<<20|r0<<16|r1<<12|r2<<8|r3<<4|r4;
+    }
+
+    // Score of the hand ranking c made of the five highest columns in mask.
+    static int top_score(int c,int mask){
+        int k[5];
+        top_ranks(mask,5,k);
+        return pack(c,k[0],k[1],k[2],k[3],k[4]);
+    }
+
+    static int straight_score(int c,int high){
+        return pack(c,high,high-1,high-2,high-3,high-4);
+    }
+
+    static int highest(int mask){
+        return 31-__builtin_clz(mask);
+    }
+
+    static int highest_or_zero(int mask){
+        return mask ? highest(mask) : 0;
+    }
+
+    // Write the n highest columns set in the mask into ranks, in decreasing
+    // order, padding with zeros.
+    static void top_ranks(int mask,int n,int * ranks){
+        for(int i=0;i<n;++i){
+            if(mask){
+                ranks[i]=highest(mask);
+                mask&=~(1<<ranks[i]);
+            }
+            else
+                ranks[i]=0;
+        }
+    }
+
+};
+
+template<class Rules>
+const string BasicHandEvaluator<Rules>::rank_names[13]={"2","3","4","5","6","7","8",
+                                                       "9","10","J","Q","K","A"};
+template<class Rules>
+const char BasicHandEvaluator<Rules>::suit_names[5]="HSDC";
+
+typedef BasicHandEvaluator<StandardRules> HandEvaluator;
@@ -0,0 +1,54 @@
+/********************************************************************************
+
+                Cards of a hand which change one card at a time.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The state of the evaluation of a hand is its suit masks (see HandEvaluator.h).
+ A card (given by its index 0,...,51) is added to or removed from the hand by
+ setting or clearing its bits, so that the hand is updated in O(1) instead of
+ building a new CheckSet for every set of cards. The hand can start from the
+ cards which are common to all the enumerated sets (e.g. the community cards
+ and the player's pocket cards).
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+class IncrementalHand{
+
+public:
+
+    IncrementalHand() : suit_masks{} {};
+    IncrementalHand(const array<int,4> & masks) : suit_masks(masks) {};
+
+    void add(int card){
+        HandEvaluator::add_card(suit_masks,card);
+    }
+    void remove(int card){
+        HandEvaluator::remove_card(suit_masks,card);
+    }
+    // Replace the card out with the card in.
+    void swap(int out,int in){
+        remove(out);
+        add(in);
+    }
+
+    // Return score of the best hand (see HandEvaluator.h).
+    int score() const{
+        return HandEvaluator::score(suit_masks);
+    }
+
+    // Interface to the private variables:
+
+    const array<int,4> & get_suit_masks() const{
+        return suit_masks;
+    }
+
+private:
+
+    array<int,4> suit_masks;
+
+};
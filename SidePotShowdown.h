@@ -0,0 +1,176 @@
+/********************************************************************************
+
+                    Showdown with the main pot and side pots.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ When players are all-in for different amounts, the chips are split into the main
+ pot and side pots. Let L_1 < L_2 < ... be the distinct total contributions of the
+ players who haven't folded. The pot k collects from every player (folded or not)
+ the part of the contribution between L_(k-1) and L_k, and can be won only by the
+ players who haven't folded and contributed at least L_k. The chips contributed
+ above the largest L_k (by the players who folded) go to the last pot.
+
+ award() gives each pot to the best hand among the players eligible for it. A
+ split pot is divided equally, and the odd chips which can't be divided go one by
+ one to the winners in the odd-chip order of the seats (e.g. starting from the
+ first seat to the left of the button). The winners missing from the given order
+ come after it, in the order of the seats, so that every pot is paid out in full.
+
+ pot_equity() finds the equity of every player in every pot from one simulation
+ (see EquitySimulator.h): every player's hand is scored once per runout, and the
+ scores are used for all the pots.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+struct Pot{
+    long amount;
+    vector<int> eligible; // Players who can win the pot, in increasing order.
+};
+
+class SidePotShowdown{
+
+public:
+
+    // contributions[p] is the total number of chips put in by player p,
+    // folded are the players who folded.
+    SidePotShowdown(const map<int,long> & contributions,const vector<int> & folded){
+        vector<long> levels;
+        for(auto c : contributions){
+            if(find(folded.begin(),folded.end(),c.first)==folded.end())
+                levels.push_back(c.second);
+        }
+        sort(levels.begin(),levels.end());
+        levels.erase(unique(levels.begin(),levels.end()),levels.end());
+        long previous=0;
+        for(long level : levels){
+            Pot pot;
+            pot.amount=0;
+            for(auto c : contributions){
+                pot.amount+=max(0L,min(c.second,level)-min(c.second,previous));
+                if(c.second>=level&&find(folded.begin(),folded.end(),c.first)==folded.end())
+                    pot.eligible.push_back(c.first);
+            }
+            pots.push_back(pot);
+            previous=level;
+        }
+        for(auto c : contributions){
+            if(c.second>previous&&pots.size()>0)
+                pots.back().amount+=c.second-previous;
+        }
+    }
+
+    const vector<Pot> & get_pots() const{
+        return pots;
+    }
+
+    // Return the chips won by each player, given the scores (see
+    // HandEvaluator.h) of the players who haven't folded, and the
+    // odd-chip order of the players.
+    map<int,long> award(const map<int,int> & scores,const vector<int> & odd_chip_order) const{
+        map<int,long> won;
+        for(const Pot & pot : pots){
+            vector<int> winners=pot_winners(pot,scores);
+            long share=pot.amount/winners.size();
+            long odd=pot.amount%winners.size();
+            for(int p : winners)
+                won[p]+=share;
+            // The winners in the odd-chip order, followed by the ones
+            // missing from it in the order of the seats.
+            vector<int> order;
+            for(int p : odd_chip_order){
+                if(find(winners.begin(),winners.end(),p)!=winners.end())
+                    order.push_back(p);
+            }
+            for(int p : winners){
+                if(find(order.begin(),order.end(),p)==order.end())
+                    order.push_back(p);
+            }
+            for(int i=0;i<odd;++i)
+                ++won[order[i]];
+        }
+        return won;
+    }
+
+    // Same as above, with the scores of the players found by the CheckSet.
+    map<int,long> award(CheckSet & checkset,const vector<int> & odd_chip_order) const{
+        map<int,int> scores;
+        for(const Pot & pot : pots){
+            for(int p : pot.eligible){
+                if(scores.find(p)==scores.end())
+                    scores[p]=checkset.hand_score(p);
+            }
+        }
+        return award(scores,odd_chip_order);
+    }
+
+    // Return the equity of every player in every pot: the report k holds the
+    // expected share of the pot k of the player with the pocket cards i of
+    // the simulator in equity[i]. players[i] is the player with the pocket
+    // cards i. The simulation stops when all the equities are found to the
+    // given precision (see EquitySimulator::simulate()).
+    vector<EquityReport> pot_equity(EquitySimulator & simulator,const vector<int> & players,
+                                    double precision,double confidence=0.95,
+                                    uint64_t max_trials=100000000) const{
+        int n=players.size();
+        // Pocket cards indexes of the players eligible for each pot.
+        vector<vector<int>> eligible(pots.size());
+        for(int k=0;k<pots.size();++k){
+            for(int i=0;i<n;++i){
+                if(find(pots[k].eligible.begin(),pots[k].eligible.end(),players[i])!=pots[k].eligible.end())
+                    eligible[k].push_back(i);
+            }
+        }
+        EquityReport all=simulator.estimate(n*pots.size(),
+            [&eligible,n](const vector<int> & scores,vector<double> & share){
+                for(int k=0;k<eligible.size();++k){
+                    int highest=-1;
+                    int n_winners=0;
+                    for(int i : eligible[k]){
+                        if(scores[i]>highest){
+                            highest=scores[i];
+                            n_winners=0;
+                        }
+                        if(scores[i]==highest)
+                            ++n_winners;
+                    }
+                    for(int i : eligible[k]){
+                        if(scores[i]==highest)
+                            share[n*k+i]+=1.0/n_winners;
+                    }
+                }
+            },precision,confidence,max_trials);
+        vector<EquityReport> reports(pots.size());
+        for(int k=0;k<pots.size();++k){
+            reports[k].equity.assign(all.equity.begin()+n*k,all.equity.begin()+n*(k+1));
+            reports[k].error.assign(all.error.begin()+n*k,all.error.begin()+n*(k+1));
+            reports[k].trials=all.trials;
+            reports[k].converged=all.converged;
+        }
+        return reports;
+    }
+
+private:
+
+    vector<Pot> pots;
+
+    static vector<int> pot_winners(const Pot & pot,const map<int,int> & scores){
+        int highest=-1;
+        vector<int> winners;
+        for(int p : pot.eligible){
+            int score=scores.at(p);
+            if(score>highest){
+                highest=score;
+                winners={};
+            }
+            if(score==highest)
+                winners.push_back(p);
+        }
+        return winners;
+    }
+
+};
@@ -0,0 +1,219 @@
+/********************************************************************************
+
+                            Seven-card stud table.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ In stud there are no community cards: each player p=1,2,... gets two down
+ cards and one up card on the 3rd street, one up card on each of the 4th, 5th
+ and 6th streets, and one down card on the 7th street. The table records the
+ up and down cards (card indexes, see HandEvaluator.h) of every player in the
+ order in which they are dealt.
+
+ Each player keeps an IncrementalHand, to which every dealt card is added, so
+ that the best hand of the player is scored on any street without rebuilding
+ the player's cards. get_cards() returns the cards as Cards of player p, which
+ CheckSet accepts for the printing and the checkers (players without community
+ cards).
+
+ equity() finds the equity of the players who haven't folded, knowing all their
+ cards. The up cards of the folded players were seen, so they are dead and are
+ removed from the deck; their down cards weren't seen and stay in the deck. The
+ missing cards of all the players are dealt in balanced sweeps: the remaining
+ deck is shuffled and dealt out to the players as many times as it lasts, and
+ the sweeps are repeated until the requested precision is reached (see
+ EquitySimulator.h).
+
+ The stub of the deck holds the cards not dealt to any player, folded or not
+ (burn cards aren't counted). If it is too short to give every live player the
+ missing cards, as with eight players on the 3rd street, the stud rule applies:
+ the 7th street card is dealt face up as a single community card, which is
+ part of the hand of every live player.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+class StudTable{
+
+public:
+
+    // Table of the players p=1,2,...
+    StudTable(const vector<int> & players) : seated(players){
+        sort(seated.begin(),seated.end());
+        for(int p : seated){
+            hands[p]=IncrementalHand();
+            up[p]={};
+            down[p]={};
+        }
+    }
+
+    // Deal the card to player p, face up or face down.
+    void deal(int p,int card,bool face_up){
+        if(face_up)
+            up[p].push_back(card);
+        else
+            down[p].push_back(card);
+        hands[p].add(card);
+    }
+
+    void fold(int p){
+        folded.push_back(p);
+    }
+
+    // Street of player p: the number of the player's cards, 3,...,7.
+    int get_street(int p){
+        return up[p].size()+down[p].size();
+    }
+
+    const vector<int> & get_up_cards(int p){
+        return up[p];
+    }
+    const vector<int> & get_down_cards(int p){
+        return down[p];
+    }
+
+    // Players who haven't folded.
+    vector<int> live_players() const{
+        vector<int> live;
+        for(int p : seated){
+            if(find(folded.begin(),folded.end(),p)==folded.end())
+                live.push_back(p);
+        }
+        return live;
+    }
+
+    // Return score of the best hand of player p on the current street
+    // (see HandEvaluator.h).
+    int hand_score(int p){
+        return hands[p].score();
+    }
+
+    // Returns vector of the winning players among the ones who haven't folded.
+    vector<int> winning_players(){
+        int highest_score=-1;
+        vector<int> winning_players;
+        for(int p : live_players()){
+            int score=hand_score(p);
+            if(score>highest_score){
+                highest_score=score;
+                winning_players={};
+            }
+            if(score==highest_score)
+                winning_players.push_back(p);
+        }
+        return winning_players;
+    }
+
+    // Cards of the players who haven't folded, as the Cards of player p.
+    vector<Card> get_cards(){
+        vector<Card> cards;
+        for(int p : live_players()){
+            for(int c : down[p])
+                cards.push_back(HandEvaluator::card(c,p));
+            for(int c : up[p])
+                cards.push_back(HandEvaluator::card(c,p));
+        }
+        return cards;
+    }
+
+    // Return the equities of the players who haven't folded, in the order of
+    // live_players(), to the given precision at the given confidence level
+    // (see EquitySimulator::simulate()). If the cards can't be dealt even with
+    // the community card, the report is empty: no trials, not converged.
+    EquityReport equity(double precision,double confidence=0.95,uint64_t max_trials=100000000,
+                        uint64_t seed=0){
+        vector<int> live=live_players();
+        uint64_t seen=0;
+        for(int p : seated){
+            for(int c : up[p])
+                seen|=1ULL<<c;
+            if(find(live.begin(),live.end(),p)!=live.end()){
+                for(int c : down[p])
+                    seen|=1ULL<<c;
+            }
+        }
+        vector<int> deck;
+        for(int c=0;c<52;++c){
+            if(!(seen>>c&1))
+                deck.push_back(c);
+        }
+        vector<IncrementalHand> known;
+        vector<int> missing;
+        int need=0;
+        int stub=52;
+        bool community=false;
+        for(int p : seated)
+            stub-=get_street(p);
+        for(int p : live){
+            known.push_back(hands[p]);
+            missing.push_back(7-get_street(p));
+            need+=missing.back();
+        }
+        if(need>stub){
+            // The 7th street card is a community card.
+            community=true;
+            need=1;
+            for(int & m : missing){
+                if(m>0)
+                    need+=--m;
+            }
+        }
+        if(need>stub){
+            EquityReport report;
+            report.equity.assign(live.size(),0);
+            report.error.assign(live.size(),0);
+            report.trials=0;
+            report.converged=false;
+            return report;
+        }
+        int strata= need==0 ? 1 : deck.size()/need;
+        mt19937_64 generator(seed);
+        SweepDealer deal_sweep={known,missing,deck,need,strata,community,generator};
+        return EquitySimulator::estimate_sweeps(live.size(),strata,need==0,deal_sweep,
+                                                EquitySimulator::add_shares,
+                                                precision,confidence,max_trials);
+    }
+
+private:
+
+    // Deals a sweep of the missing cards of the players, for
+    // EquitySimulator::estimate_sweeps().
+    struct SweepDealer{
+        const vector<IncrementalHand> & known;
+        const vector<int> & missing;
+        vector<int> & deck;
+        int need;
+        int strata;
+        bool community;
+        mt19937_64 & generator;
+        template<class G>
+        void operator()(G on_runout) const{
+            vector<int> scores(known.size());
+            if(need>0)
+                shuffle(deck.begin(),deck.end(),generator);
+            for(int r=0;r<strata;++r){
+                int next=r*need;
+                int shared= community ? deck[next++] : -1;
+                for(int i=0;i<known.size();++i){
+                    IncrementalHand hand=known[i];
+                    for(int k=0;k<missing[i];++k)
+                        hand.add(deck[next++]);
+                    if(community)
+                        hand.add(shared);
+                    scores[i]=hand.score();
+                }
+                on_runout(scores);
+            }
+        }
+    };
+
+    vector<int> seated;
+    vector<int> folded;
+    map<int,IncrementalHand> hands;
+    map<int,vector<int>> up;
+    map<int,vector<int>> down;
+
+};
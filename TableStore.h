@@ -0,0 +1,249 @@
+/********************************************************************************
+
+                    Store of many independent Hold'em tables.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ The tables are kept in structure-of-arrays form: each attribute of all the tables
+ is stored in its own contiguous array, indexed by the table number t (and the
+ seat number s=0,...,seats-1 for the per-seat attributes):
+
+ board -- card indexes (see HandEvaluator.h) of the community cards,
+          5 per table, board[5 * t + i].
+ hole -- card indexes of the pocket cards, 2 per seat,
+         hole[2 * (seats * t + s) + i].
+ occupancy -- bit s is set if the seat s of the table is taken by a player.
+ street -- number of community cards dealt: 0 (pre-flop), 3, 4 or 5.
+ winners -- bit s is set if the seat s won the last showdown.
+
+ A card takes a single byte, the suit masks used by HandEvaluator are made from
+ the card indexes when the table is evaluated. With 9 seats a table takes 28
+ bytes, so that a million tables fit in 28 MB.
+
+ The bulk operations deal(), advance_street(), evaluate() and resolve_winners()
+ process all the tables, optionally splitting them between several threads.
+ The cards of table t are drawn from the random stream defined by the seed, t,
+ the number of the deal and the street, so that the result doesn't depend on
+ the number of threads. The tables hold no cards before the first deal(); a
+ seat taken in the middle of a hand is dealt its pocket cards by set_seat(),
+ from its own stream, so that every taken seat always holds two live cards.
+
+                    %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+********************************************************************************/
+
+using namespace std;
+
+class TableStore{
+
+public:
+
+    // Store of n_tables tables with seats_per_table seats (at most 16),
+    // with all the seats taken.
+    TableStore(int n_tables,int seats_per_table,uint64_t s) :
+        tables(n_tables), seats(seats_per_table), seed(s), deal_number(0),
+        board(5*n_tables,0), hole(2*seats_per_table*n_tables,0),
+        occupancy(n_tables,(1<<seats_per_table)-1), street(n_tables,0),
+        winners(n_tables,0) {};
+
+    // Take (free) the seat s of table t. A seat taken after deal() gets its
+    // two pocket cards from the rest of the deck of the current hand.
+    void set_seat(int t,int s,bool taken){
+        if(!taken){
+            occupancy[t]&=~(1<<s);
+            return;
+        }
+        if(occupancy[t]>>s&1)
+            return;
+        if(deal_number>0){
+            uint64_t used=dealt_cards(t);
+            uint64_t state=stream(t,8+s);
+            for(int i=0;i<2;++i)
+                hole[2*(seats*t+s)+i]=draw(state,used);
+        }
+        occupancy[t]|=1<<s;
+    }
+
+    // Deal the pocket cards to all the taken seats of all the tables,
+    // and clear the community cards.
+    void deal(int threads=1){
+        ++deal_number;
+        for_each_range(threads,[this](int begin,int end){
+            for(int t=begin;t<end;++t){
+                street[t]=0;
+                winners[t]=0;
+                uint64_t used=0;
+                uint64_t state=stream(t,0);
+                for(int s=0;s<seats;++s){
+                    if(!(occupancy[t]>>s&1))
+                        continue;
+                    for(int i=0;i<2;++i)
+                        hole[2*(seats*t+s)+i]=draw(state,used);
+                }
+            }
+        });
+    }
+
+    // Deal the next street (flop, turn or river) on all the tables.
+    void advance_street(int threads=1){
+        for_each_range(threads,[this](int begin,int end){
+            for(int t=begin;t<end;++t){
+                int n=street[t];
+                if(n==5)
+                    continue;
+                uint64_t used=dealt_cards(t);
+                uint64_t state=stream(t,n+1);
+                int next= n==0 ? 3 : n+1;
+                for(int i=n;i<next;++i)
+                    board[5*t+i]=draw(state,used);
+                street[t]=next;
+            }
+        });
+    }
+
+    // Write the score (see HandEvaluator.h) of every seat into
+    // scores[seats * t + s], or -1 for the free seats.
+    void evaluate(vector<int> & scores,int threads=1){
+        scores.resize(seats*tables);
+        for_each_range(threads,[this,&scores](int begin,int end){
+            for(int t=begin;t<end;++t){
+                array<int,4> board_masks=HandEvaluator::suit_masks(board_cards(t));
+                for(int s=0;s<seats;++s)
+                    scores[seats*t+s]= occupancy[t]>>s&1 ? seat_score(t,s,board_masks) : -1;
+            }
+        });
+    }
+
+    // Find the winning seats of every table.
+    void resolve_winners(int threads=1){
+        for_each_range(threads,[this](int begin,int end){
+            for(int t=begin;t<end;++t){
+                array<int,4> board_masks=HandEvaluator::suit_masks(board_cards(t));
+                int highest_score=-1;
+                uint16_t won=0;
+                for(int s=0;s<seats;++s){
+                    if(!(occupancy[t]>>s&1))
+                        continue;
+                    int score=seat_score(t,s,board_masks);
+                    if(score>highest_score){
+                        highest_score=score;
+                        won=0;
+                    }
+                    if(score==highest_score)
+                        won|=1<<s;
+                }
+                winners[t]=won;
+            }
+        });
+    }
+
+    // Return the Cards of the table t: the community cards (p=-1) and the
+    // pocket cards of the seat s as player p=s+1, e.g. for CheckSet.
+    vector<Card> get_cards(int t){
+        vector<Card> cards;
+        for(int i=0;i<street[t];++i)
+            cards.push_back(HandEvaluator::card(board[5*t+i],-1));
+        for(int s=0;s<seats;++s){
+            if(!(occupancy[t]>>s&1))
+                continue;
+            for(int i=0;i<2;++i)
+                cards.push_back(HandEvaluator::card(hole[2*(seats*t+s)+i],s+1));
+        }
+        return cards;
+    }
+
+    // Interface to the private variables:
+
+    int get_tables() const{
+        return tables;
+    }
+    int get_seats() const{
+        return seats;
+    }
+    int get_street(int t) const{
+        return street[t];
+    }
+    uint16_t get_occupancy(int t) const{
+        return occupancy[t];
+    }
+    uint16_t get_winners(int t) const{
+        return winners[t];
+    }
+
+private:
+
+    int tables;
+    int seats;
+    uint64_t seed;
+    uint64_t deal_number;
+    vector<uint8_t> board;
+    vector<uint8_t> hole;
+    vector<uint16_t> occupancy;
+    vector<uint8_t> street;
+    vector<uint16_t> winners;
+
+    // Set of the community cards of table t.
+    uint64_t board_cards(int t) const{
+        uint64_t cards=0;
+        for(int i=0;i<street[t];++i)
+            cards|=1ULL<<board[5*t+i];
+        return cards;
+    }
+
+    // Set of all the cards dealt at table t.
+    uint64_t dealt_cards(int t) const{
+        uint64_t cards=board_cards(t);
+        for(int s=0;s<seats;++s){
+            if(occupancy[t]>>s&1)
+                cards|=1ULL<<hole[2*(seats*t+s)]|1ULL<<hole[2*(seats*t+s)+1];
+        }
+        return cards;
+    }
+
+    int seat_score(int t,int s,array<int,4> masks) const{
+        HandEvaluator::add_card(masks,hole[2*(seats*t+s)]);
+        HandEvaluator::add_card(masks,hole[2*(seats*t+s)+1]);
+        return HandEvaluator::score(masks);
+    }
+
+    // Initial state of the random stream of table t at the given street, or
+    // n=8+s for the pocket cards of the seat s taken in the middle of a hand.
+    uint64_t stream(int t,int n) const{
+        return seed^(uint64_t(t)*0x9E3779B97F4A7C15ULL)
+                   ^(deal_number*0xC2B2AE3D27D4EB4FULL)^(uint64_t(n)<<56);
+    }
+
+    // splitmix64 step.
+    static uint64_t next_random(uint64_t & state){
+        uint64_t z=(state+=0x9E3779B97F4A7C15ULL);
+        z=(z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+        z=(z^(z>>27))*0x94D049BB133111EBULL;
+        return z^(z>>31);
+    }
+
+    // Draw a card which is not in used, and add it to used.
+    static uint8_t draw(uint64_t & state,uint64_t & used){
+        int c;
+        do{
+            c=int((next_random(state)>>32)*52>>32);
+        }while(used>>c&1);
+        used|=1ULL<<c;
+        return uint8_t(c);
+    }
+
+    // Call f(begin,end) on the ranges of tables, one range per thread.
+    template<class F>
+    void for_each_range(int threads,F f){
+        if(threads<=1||tables<2){
+            f(0,tables);
+            return;
+        }
+        vector<thread> workers;
+        int chunk=(tables+threads-1)/threads;
+        for(int begin=0;begin<tables;begin+=chunk)
+            workers.push_back(thread(f,begin,min(tables,begin+chunk)));
+        for(thread & w : workers)
+            w.join();
+    }
+
+};
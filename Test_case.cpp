@@ -26,9 +26,13 @@
 #include <cstdlib>
 #include <random>
 #include <time.h>
+#include <cstdint>
 
 #include "Card.h"
+#include "DeckRules.h"
 // #include "Deck.h"
+#include "HandEvaluator.h"
+#include "BoardSummary.h"
 #include "CheckSet.h"
 
 using namespace std;
@@ -67,12 +71,13 @@ int main(){
     checkset.printTotalCardTable();
     
     for(int p=1;p<9;++p){
-        vector<Card> res=checkset.bestHand(p);
+        HandResult result=checkset.classify(p);
+        const vector<Card> & res=result.cards();
         if(res.size()!=0){
 
             checkset.printPlayersCards(p);
             checkset.printPlayerCardTable(p);
-            cout << "Best hand of player " << p << " is " << endl;
+            cout << "Best hand of player " << p << " (rank " << result.category() << ") is " << endl;
             for(Card c : res)
                 cout << "(" <<c.rank << " " << c.suit << " " << c.player << ") ";
             cout << endl;
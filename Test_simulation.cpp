@@ -0,0 +1,104 @@
+/********************************************************************************
+
+ Example of the fast evaluation and simulation modules, which work with the
+ card indexes (see HandEvaluator.h) instead of the Card objects:
+
+     TableStore -- many Hold'em tables dealt and resolved in bulk.
+     EquitySimulator -- equity of Hold'em players, split into the side pots
+                        with SidePotShowdown.
+     FlopTextureIndex -- features of a flop looked up in O(1).
+     DrawAnalyzer -- best discard in the five-card draw.
+     StudTable -- Seven-card stud hands and equity.
+
+ The headers don't include the standard headers nor each other, so they have to
+ be included in the order below, after the standard headers (<thread> is needed
+ by TableStore and DrawAnalyzer, <cmath> by EquitySimulator). Compile with
+ -pthread.
+
+********************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <cmath>
+#include <thread>
+#include <cstdint>
+
+#include "Card.h"
+#include "DeckRules.h"
+#include "HandEvaluator.h"
+#include "BoardSummary.h"
+#include "CheckSet.h"
+#include "IncrementalHand.h"
+#include "CombinationWalker.h"
+#include "TableStore.h"
+#include "EquitySimulator.h"
+#include "FlopTextureIndex.h"
+#include "DrawAnalyzer.h"
+#include "SidePotShowdown.h"
+#include "StudTable.h"
+
+using namespace std;
+
+int card(const string & rank,char suit){
+    return HandEvaluator::card_index(Card(rank,suit,0));
+}
+
+void print_report(const EquityReport & report){
+    for(int i=0;i<report.equity.size();++i)
+        cout << report.equity[i] << " +- " << report.error[i] << "  ";
+    cout << "(" << report.trials << " runouts)" << endl;
+}
+
+int main(){
+
+    // Deal 1000 tables of 6 seats to the river on 2 threads, with a seat
+    // taken in the middle of the hand, and print the first table.
+    TableStore store(1000,6,1);
+    store.set_seat(0,5,false);
+    store.deal(2);
+    store.set_seat(0,5,true);
+    for(int street=0;street<3;++street)
+        store.advance_street(2);
+    store.resolve_winners(2);
+    CheckSet table(store.get_cards(0));
+    table.printTotalCardTable();
+    cout << "Table 0 is won by the seats (bits) " << store.get_winners(0) << endl;
+
+    // Three players all-in pre-flop for different amounts.
+    EquitySimulator simulator({{card("A",'S'),card("A",'H')},
+                               {card("K",'D'),card("K",'C')},
+                               {card("7",'S'),card("8",'S')}},{},{},1);
+    SidePotShowdown showdown({{1,100},{2,300},{3,300}},{});
+    vector<EquityReport> pots=showdown.pot_equity(simulator,{1,2,3},0.005);
+    for(int k=0;k<pots.size();++k){
+        cout << "Pot " << k << " of " << showdown.get_pots()[k].amount << " chips: ";
+        print_report(pots[k]);
+    }
+
+    const FlopTexture & flop=FlopTextureIndex::shared().lookup(card("J",'H'),card("10",'H'),card("2",'C'));
+    cout << "Flop J H, 10 H, 2 C: two-tone " << flop.two_tone << ", straight possible "
+         << flop.straight_possible << ", flush draw " << flop.flush_draw << endl;
+
+    DrawAnalyzer analyzer;
+    DrawOption draw=analyzer.best({card("A",'S'),card("K",'S'),card("Q",'S'),
+                                   card("J",'S'),card("3",'D')});
+    cout << "Best hold (bits) " << draw.hold << " with the expected value "
+         << draw.expected_value << endl;
+
+    StudTable stud({1,2});
+    stud.deal(1,card("A",'S'),false);
+    stud.deal(1,card("A",'D'),false);
+    stud.deal(1,card("9",'C'),true);
+    stud.deal(2,card("8",'H'),false);
+    stud.deal(2,card("9",'H'),false);
+    stud.deal(2,card("10",'H'),true);
+    cout << "Stud equity on the 3rd street: ";
+    print_report(stud.equity(0.005));
+
+    return 0;
+}